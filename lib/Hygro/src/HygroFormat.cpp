@@ -0,0 +1,199 @@
+#include "HygroFormat.h"
+
+#include <stdio.h>
+
+void formatChannelKey(char* out, size_t size, const char* prefix, int ch) {
+  snprintf(out, size, "%s_%d", prefix, ch);
+}
+
+void forEachChannelKey(const char* prefix, ChannelKeyFn fn, void* ctx) {
+  char key[NVS_KEY_LEN];
+  for (int ch = 0; ch < HYGRO_NUM_CHANNELS; ++ch) {
+    formatChannelKey(key, sizeof(key), prefix, ch);
+    fn(key, ch, ctx);
+  }
+}
+
+void formatChannelTopic(char* out, size_t size, int ch) {
+  snprintf(out, size, "hygrometer/channel%d/state", ch);
+}
+
+void formatChannelPayload(char* out, size_t size, float r, float index) {
+  if (index >= 0) formatValue(out, size, index, 2);
+  else formatValue(out, size, r, 1);
+}
+
+void formatValue(char* out, size_t size, float value, int decimals) {
+  snprintf(out, size, "%.*f", decimals, value);
+}
+
+void renderMetrics(ResponseWriter& out, const HygroState& st) {
+  if (st.hasSHT) {
+    out.add("# HELP hygrometer_ambient_temperature_celsius Ambient temperature from SHT31\n");
+    out.add("# TYPE hygrometer_ambient_temperature_celsius gauge\n");
+    out.addf("hygrometer_ambient_temperature_celsius %.2f\n", st.ambientTemp);
+    out.add("# HELP hygrometer_ambient_humidity_percent Ambient humidity from SHT31\n");
+    out.add("# TYPE hygrometer_ambient_humidity_percent gauge\n");
+    out.addf("hygrometer_ambient_humidity_percent %.2f\n", st.ambientHum);
+  }
+
+  // Configuration Info
+  out.add("# HELP hygrometer_config_reference_dry_channel Channel used as dry baseline (-1 if none)\n");
+  out.addf("hygrometer_config_reference_dry_channel %d\n", st.refChannel);
+  out.add("# HELP hygrometer_config_global_wet_ohms Global fixed wet limit\n");
+  out.addf("hygrometer_config_global_wet_ohms %.2f\n", st.globalWetR);
+
+  // Heap-Zustand: sinkender größter Block = Fragmentierung
+  out.add("# HELP hygrometer_heap_free_bytes Free heap\n");
+  out.add("# TYPE hygrometer_heap_free_bytes gauge\n");
+  out.addf("hygrometer_heap_free_bytes %u\n", (unsigned)st.heapFree);
+  out.add("# HELP hygrometer_heap_largest_block_bytes Largest allocatable heap block\n");
+  out.add("# TYPE hygrometer_heap_largest_block_bytes gauge\n");
+  out.addf("hygrometer_heap_largest_block_bytes %u\n", (unsigned)st.heapLargest);
+
+  for (int ch = 0; ch < HYGRO_NUM_CHANNELS; ++ch) {
+    const ChannelReading& c = st.channels[ch];
+
+    out.add("# HELP hygrometer_adc_raw Raw ADC value from mux\n");
+    out.addf("hygrometer_adc_raw{channel=\"%d\"} %.1f\n", ch, c.adc);
+    
+    out.add("# HELP hygrometer_voltage_volts Measured voltage at Z pin\n");
+    out.addf("hygrometer_voltage_volts{channel=\"%d\"} %.3f\n", ch, c.vout);
+
+    out.add("# HELP hygrometer_resistance_ohms Raw resistance measured at probe\n");
+    out.addf("hygrometer_resistance_ohms{channel=\"%d\"} %.2f\n", ch, c.r);
+    
+    out.add("# HELP hygrometer_effective_dry_ohms Used dry limit for index calculation\n");
+    out.addf("hygrometer_effective_dry_ohms{channel=\"%d\"} %.2f\n", ch, c.dryLimit);
+    
+    out.add("# HELP hygrometer_effective_wet_ohms Used wet limit for index calculation\n");
+    out.addf("hygrometer_effective_wet_ohms{channel=\"%d\"} %.2f\n", ch, c.wetLimit);
+    
+    if (c.index >= 0) {
+      out.add("# HELP hygrometer_index_percent Calculated moisture index\n");
+      out.addf("hygrometer_index_percent{channel=\"%d\"} %.2f\n", ch, c.index);
+    }
+  }
+}
+
+void renderRoot(ResponseWriter& out, const HygroState& st) {
+  out.add("<!DOCTYPE html><html><head>");
+  out.add("<meta charset='UTF-8'>");
+  if (st.autoRefresh) {
+    out.add("<meta http-equiv='refresh' content='10'>");
+  }
+  out.add("<meta name='viewport' content='width=device-width, initial-scale=1'>");
+  out.add("<title>Hygrometer Control</title>");
+  out.add("<link href='https://cdn.jsdelivr.net/npm/bootstrap@5.3.0/dist/css/bootstrap.min.css' rel='stylesheet'>");
+  out.add("<link href='https://cdnjs.cloudflare.com/ajax/libs/font-awesome/6.4.0/css/all.min.css' rel='stylesheet'>");
+  out.add("<style>");
+  out.add("body { background-color: #f8f9fa; }");
+  out.add(".card { margin-bottom: 20px; box-shadow: 0 4px 6px rgba(0,0,0,0.1); }");
+  out.add(".status-val { font-size: 1.2rem; font-weight: bold; }");
+  out.add(".ch-label { width: 40px; display: inline-block; }");
+  out.add(".fa-circle-question { font-size: 0.8rem; color: #6c757d; cursor: help; margin-left: 2px; }");
+  out.add(".bg-orange { background-color: #fd7e14 !important; color: white !important; }"); // Bootstrap Orange Custom
+  out.add("</style></head><body>");
+  
+  out.add("<nav class='navbar navbar-dark bg-primary mb-4'><div class='container-fluid'>");
+  out.add("<span class='navbar-brand'><i class='fa-solid fa-droplet me-2'></i>Hygrometer Dashboard</span>");
+  out.add("</div></nav>");
+
+  out.add("<div class='container'><div class='row'>");
+  
+  // Left Column: Environment & Status
+  out.add("<div class='col-md-4'>");
+  out.add("<div class='card'><div class='card-header bg-white'><i class='fa-solid fa-wind me-2'></i>Ambient Sensors</div><div class='card-body'>");
+  if (st.hasSHT) {
+    out.addf("<p><i class='fa-solid fa-temperature-half me-2 text-danger'></i>Temp: <span class='status-val'>%.1f °C</span></p>", st.ambientTemp);
+    out.addf("<p><i class='fa-solid fa-cloud-showers-heavy me-2 text-primary'></i>Humidity: <span class='status-val'>%.0f %%</span></p>", st.ambientHum);
+  } else {
+    out.add("<div class='alert alert-warning small py-1 px-2'>SHT31 not found</div>");
+  }
+  out.add("</div></div>");
+
+  out.add("<div class='card'><div class='card-header bg-white'><i class='fa-solid fa-link me-2'></i>Endpoints</div><div class='card-body d-grid gap-2'>");
+  out.add("<a href='/metrics' class='btn btn-outline-secondary btn-sm text-start'><i class='fa-solid fa-chart-line me-2'></i>Prometheus Metrics</a>");
+  out.add("<form action='/reboot' method='POST' onsubmit='return confirm(\"Reboot ESP32?\");'>");
+  out.add("<button type='submit' class='btn btn-danger btn-sm w-100'><i class='fa-solid fa-power-off me-2'></i>Reboot ESP</button></form>");
+  out.add("</div></div>");
+  out.add("</div>");
+
+  // Right Column: Configuration
+  out.add("<div class='col-md-8'>");
+  out.add("<form action='/save' method='POST'>");
+  
+  // Channel Table
+  out.add("<div class='card'><div class='card-header bg-white d-flex justify-content-between align-items-center small'>");
+  out.add("<span><i class='fa-solid fa-screwdriver-wrench me-2'></i>Probe Measurements</span>");
+  if (st.refChannel >= 0) out.addf("<span class='badge bg-info text-dark'>Ref Dry: CH%d</span></div>", st.refChannel);
+  else out.add("<span class='badge bg-info text-dark'>Ref Dry: None</span></div>");
+  out.add("<div class='card-body p-0'><div class='table-responsive'><table class='table table-hover table-sm mb-0'><thead><tr class='table-light'>");
+  out.add("<th>CH <i class='fa-solid fa-circle-question' title='Multiplexer Channel (0-7)'></i></th>");
+  out.add("<th>Raw Ω <i class='fa-solid fa-circle-question' title='Human readable resistance (k=kiloohm, M=megaohm)'></i></th>");
+  out.add("<th>Plain (Metric) <i class='fa-solid fa-circle-question' title='Exact decimal resistance in Ohms for metrics and calibration'></i></th>");
+  out.add("<th>ADC <i class='fa-solid fa-circle-question' title='Raw Digital value (0-4095) from the ESP32 ADC pin'></i></th>");
+  out.add("<th>Vout <i class='fa-solid fa-circle-question' title='Converted voltage reading (0-3.3V)'></i></th>");
+  out.add("<th class='text-end'>Moisture Index <i class='fa-solid fa-circle-question' title='Calculated percentage relative to Dry and Wet references'></i></th></tr></thead><tbody>");
+  for (int i = 0; i < HYGRO_NUM_CHANNELS; ++i) {
+    const ChannelReading& c = st.channels[i];
+    out.addf("<tr><td class='fw-bold'>%d</td>", i);
+    if (c.r > 999999) out.addf("<td><small>%.1fM Ω</small></td>", c.r/1000000.0);
+    else if (c.r > 999) out.addf("<td><small>%.0fk Ω</small></td>", c.r/1000.0);
+    else out.addf("<td><small>%.0f Ω</small></td>", c.r);
+    out.addf("<td><code>%.2f</code></td>", c.r);
+    out.addf("<td><small class='text-muted'>%.1f</small></td>", c.adc);
+    out.addf("<td><small class='text-muted'>%.3fV</small></td>", c.vout);
+    const char* badgeColor = "bg-success";
+    const char* textColor = "text-dark";
+    if (c.index > 85) { badgeColor = "bg-danger"; textColor = "text-white"; }
+    else if (c.index > 60) { badgeColor = "bg-orange"; textColor = "text-white"; }
+    else if (c.index > 25) { badgeColor = "bg-warning"; textColor = "text-dark"; }
+    
+    out.addf("<td class='text-end'><span class='badge %s %s'>%.0f%%</span></td></tr>", badgeColor, textColor, c.index);
+  }
+  out.add("</tbody></table></div></div></div>");
+
+  // System Settings
+  out.add("<div class='card'><div class='card-header bg-white'><i class='fa-solid fa-gears me-2'></i>System Settings</div><div class='card-body small'>");
+  out.add("<div class='row g-3'>");
+  out.add("<div class='col-sm-6'><label class='form-label mb-0'>Dry Reference</label><select class='form-select form-select-sm' name='ref_ch'><option value='-1'>None (Manual)</option>");
+  for (int i = 0; i < HYGRO_NUM_CHANNELS; ++i) out.addf("<option value='%d' %s>CH %d</option>", i, st.refChannel == i ? "selected" : "", i);
+  out.add("</select></div>");
+  out.add("<div class='col-sm-6'><label class='form-label mb-0'>Global Wet Value (100%)</label><input type='number' step='any' class='form-control form-control-sm' name='global_wet_r' ");
+  out.addf("value='%.2f' placeholder='e.g. 20000.00'></div>", st.globalWetR);
+  
+  // Interval with unit selector
+  unsigned long displayInterval = st.measureIntervalMs / 1000;
+  char unit = 's';
+  if (st.measureIntervalMs >= 60000 && st.measureIntervalMs % 60000 == 0) {
+    displayInterval = st.measureIntervalMs / 60000;
+    unit = 'm';
+  }
+  out.add("<div class='col-sm-6'><label class='form-label mb-0'>Interval (Unit)</label><div class='input-group input-group-sm'>");
+  out.addf("<input type='number' class='form-control' name='interval_val' value='%lu'>", displayInterval);
+  out.add("<select class='form-select' style='max-width: 80px;' name='interval_unit'>");
+  out.addf("<option value='s' %s>sec</option>", unit == 's' ? "selected" : "");
+  out.addf("<option value='m' %s>min</option>", unit == 'm' ? "selected" : "");
+  out.add("</select></div></div>");
+
+  out.add("<div class='col-sm-6 d-flex align-items-end gap-3'>");
+  out.addf("<div class='form-check form-switch'><input class='form-check-input' type='checkbox' name='mqtt_enabled' value='1' %s><label class='form-check-label'>MQTT</label></div>", st.mqttEnabled ? "checked" : "");
+  out.addf("<div class='form-check form-switch'><input class='form-check-input' type='checkbox' name='lcd_enabled' value='1' %s><label class='form-check-label'>LCD</label></div>", st.lcdEnabled ? "checked" : "");
+  out.addf("<div class='form-check form-switch'><input class='form-check-input' type='checkbox' name='auto_refresh' value='1' %s><label class='form-check-label'>Auto-Refresh</label></div>", st.autoRefresh ? "checked" : "");
+  out.add("</div>");
+
+  out.add("<div class='col-sm-12'><hr class='my-2'></div>");
+  out.add("<div class='col-md-6'><label class='form-label mb-0 small'>MQTT Server</label><input type='text' class='form-control form-control-sm' name='mqtt_server' value='");
+  out.add(st.mqttServer); out.add("'></div>");
+  out.addf("<div class='col-md-2'><label class='form-label mb-0 small'>Port</label><input type='number' class='form-control form-control-sm' name='mqtt_port' value='%u'></div>", (unsigned)st.mqttPort);
+  out.add("<div class='col-md-2'><label class='form-label mb-0 small'>User</label><input type='text' class='form-control form-control-sm' name='mqtt_user' value='");
+  out.add(st.mqttUser); out.add("'></div>");
+  out.add("<div class='col-md-2'><label class='form-label mb-0 small'>Pass</label><input type='password' class='form-control form-control-sm' name='mqtt_pass' value='");
+  out.add(st.mqttPass); out.add("'></div>");
+  
+  out.add("<div class='col-12 mt-4'><button type='submit' class='btn btn-primary w-100 btn-sm'><i class='fa-solid fa-floppy-disk me-2'></i>Save Configuration</button></div>");
+  out.add("</div></div></div>");
+  
+  out.add("</div></form></div></div></body></html>");
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ResponseWriter.h"
+
+const int HYGRO_NUM_CHANNELS = 8;
+
+// Puffergrößen für die festen Strings (NVS erlaubt max. 15 Zeichen pro Schlüssel)
+const size_t NVS_KEY_LEN = 16;
+const size_t MQTT_TOPIC_LEN = 32;
+const size_t MQTT_PAYLOAD_LEN = 24;
+
+struct ChannelReading {
+  float adc;
+  float vout;
+  float r;
+  float dryLimit; // effektive Grenzen aus getEffectiveLimits()
+  float wetLimit;
+  float index;
+};
+
+// Momentaufnahme von Messwerten und Einstellungen für die Webseiten
+struct HygroState {
+  bool hasSHT;
+  float ambientTemp;
+  float ambientHum;
+  ChannelReading channels[HYGRO_NUM_CHANNELS];
+  uint32_t heapFree;
+  uint32_t heapLargest;
+
+  int refChannel;
+  float globalWetR;
+  bool mqttEnabled;
+  bool lcdEnabled;
+  bool autoRefresh;
+  const char* mqttServer;
+  uint16_t mqttPort;
+  const char* mqttUser;
+  const char* mqttPass;
+  unsigned long measureIntervalMs;
+};
+
+// "dry_3", "wet_3", ...
+void formatChannelKey(char* out, size_t size, const char* prefix, int ch);
+// Ruft fn für jeden Kanal mit dessen NVS-Schlüssel auf (Schlüssel liegt auf dem Stack)
+typedef void (*ChannelKeyFn)(const char* key, int ch, void* ctx);
+void forEachChannelKey(const char* prefix, ChannelKeyFn fn, void* ctx);
+// "hygrometer/channel3/state"
+void formatChannelTopic(char* out, size_t size, int ch);
+// Moisture-Index, falls vorhanden, sonst der Widerstand
+void formatChannelPayload(char* out, size_t size, float r, float index);
+void formatValue(char* out, size_t size, float value, int decimals);
+
+void renderMetrics(ResponseWriter& out, const HygroState& st);
+void renderRoot(ResponseWriter& out, const HygroState& st);
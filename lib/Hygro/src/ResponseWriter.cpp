@@ -0,0 +1,57 @@
+#include "ResponseWriter.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+void ResponseWriter::add(const char* s) {
+  size_t n = strlen(s);
+  while (n > 0) {
+    if (len == CAPACITY) flush();
+    size_t chunk = CAPACITY - len;
+    if (chunk > n) chunk = n;
+    memcpy(buf + len, s, chunk);
+    len += chunk;
+    s += chunk;
+    n -= chunk;
+  }
+}
+
+void ResponseWriter::addf(const char* fmt, ...) {
+  // Direkt in den freien Rest formatieren; passt es nicht, flushen und neu formatieren
+  va_list args;
+  va_start(args, fmt);
+  int n = vsnprintf(buf + len, CAPACITY - len, fmt, args);
+  va_end(args);
+  if (n < 0) return;
+  if ((size_t)n < CAPACITY - len) {
+    len += n;
+    return;
+  }
+
+  flush();
+  va_start(args, fmt);
+  n = vsnprintf(buf, CAPACITY, fmt, args);
+  va_end(args);
+  if (n < 0) return;
+  if ((size_t)n >= CAPACITY) {
+    // Passt nicht einmal in den leeren Puffer: abgeschnitten senden und melden
+    ++truncated;
+    len = CAPACITY - 1;
+    return;
+  }
+  len = n;
+}
+
+void ResponseWriter::flush() {
+  if (len == 0) return;
+  sink.write(buf, len);
+  len = 0;
+}
+
+size_t ResponseWriter::finish() {
+  flush();
+  size_t t = truncated;
+  truncated = 0;
+  return t;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+
+// Ziel für gepufferte Ausgabe: auf dem ESP der WebServer (chunked),
+// im Host-Test ein Zähler
+class ResponseSink {
+public:
+  virtual void write(const char* data, size_t len) = 0;
+
+protected:
+  ~ResponseSink() {}
+};
+
+// Baut eine Antwort in einem festen Puffer auf und gibt ihn an den Sink weiter,
+// sobald er voll ist - kein Heap-String pro Seite
+class ResponseWriter {
+public:
+  static const size_t CAPACITY = 1024;
+
+  explicit ResponseWriter(ResponseSink& sink) : sink(sink) {}
+
+  void add(const char* s);
+  void addf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+  void flush();
+
+  // Flusht und liefert die Anzahl der seit dem letzten finish() abgeschnittenen
+  // addf()-Aufrufe (Ausgabe länger als CAPACITY)
+  size_t finish();
+
+private:
+  ResponseSink& sink;
+  char buf[CAPACITY];
+  size_t len = 0;
+  size_t truncated = 0;
+};
@@ -7,6 +7,7 @@
 #include <Adafruit_SHT31.h>
 #include <LiquidCrystal_I2C.h>
 #include "secrets.h"
+#include "HygroFormat.h"
 
 // === User configuration - edit these ===
 const char* WIFI_SSID = DEFAULT_WIFI_SSID;
@@ -27,7 +28,7 @@ const int MUX_S2 = 27; // GPIO 27 → S2/C (Mux Pin 9)
 // EN (Mux Pin 6) ist fest auf GND verdrahtet - kein GPIO nötig
 const int ADC_PIN = 34; // GPIO 34 ← Z/SIG (Mux Pin 3)
 
-const int NUM_CHANNELS = 8;
+const int NUM_CHANNELS = HYGRO_NUM_CHANNELS;
 const int SAMPLES = 8;
 const float VCC = 3.3;
 const float RS = 100000.0; // series resistor in ohms (adjustable)
@@ -63,6 +64,30 @@ int lcdScrollBatch = 0; // 0: C0-1, 1: C2-3, 2: C4-5, 3: C6-7
 
 uint8_t muxSelectPins[3] = {MUX_S0, MUX_S1, MUX_S2};
 
+// Gibt den Puffer des ResponseWriter als HTTP-Chunk an den WebServer weiter
+class ServerSink : public ResponseSink {
+public:
+  void write(const char* data, size_t len) override { server.sendContent(data, len); }
+};
+
+static ServerSink serverSink;
+// Die Seiten werden in diesen festen Puffer geschrieben statt als String auf dem Heap
+static ResponseWriter resp(serverSink);
+static HygroState pageState;
+
+void respBegin(const char* contentType) {
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, contentType, "");
+}
+
+void respEnd() {
+  size_t truncated = resp.finish();
+  server.sendContent("", 0); // Abschluss-Chunk
+  if (truncated) {
+    Serial.print("WARNING: "); Serial.print(truncated); Serial.println(" response line(s) truncated");
+  }
+}
+
 void setMuxChannel(int ch) {
   // Setze die 3 Adressleitungen (S0, S1, S2) um den Kanal 0-7 zu wählen
   for (int b = 0; b < 3; ++b) digitalWrite(muxSelectPins[b], (ch >> b) & 1);
@@ -170,57 +195,58 @@ float indexFromR(float r, int ch) {
   return 0;
 }
 
-void handleMetrics() {
-  String body;
-  
-  if (hasSHT) {
-    body += "# HELP hygrometer_ambient_temperature_celsius Ambient temperature from SHT31\n";
-    body += "# TYPE hygrometer_ambient_temperature_celsius gauge\n";
-    body += "hygrometer_ambient_temperature_celsius " + String(ambientTemp, 2) + "\n";
-    body += "# HELP hygrometer_ambient_humidity_percent Ambient humidity from SHT31\n";
-    body += "# TYPE hygrometer_ambient_humidity_percent gauge\n";
-    body += "hygrometer_ambient_humidity_percent " + String(ambientHum, 2) + "\n";
+// Füllt pageState mit aktuellen Messwerten und Einstellungen
+void collectPageState() {
+  pageState.hasSHT = hasSHT;
+  pageState.ambientTemp = ambientTemp;
+  pageState.ambientHum = ambientHum;
+  for (int ch = 0; ch < NUM_CHANNELS; ++ch) {
+    ChannelReading& c = pageState.channels[ch];
+    c.r = readChannelResistance(ch, &c.adc, &c.vout);
+    getEffectiveLimits(ch, c.dryLimit, c.wetLimit);
+    c.index = indexFromR(c.r, ch);
   }
+  pageState.heapFree = ESP.getFreeHeap();
+  pageState.heapLargest = ESP.getMaxAllocHeap();
+
+  pageState.refChannel = refChannel;
+  pageState.globalWetR = globalWetR;
+  pageState.mqttEnabled = mqttEnabled;
+  pageState.lcdEnabled = lcdEnabled;
+  pageState.autoRefresh = autoRefresh;
+  pageState.mqttServer = mqttServer.c_str();
+  pageState.mqttPort = mqttPort;
+  pageState.mqttUser = mqttUser.c_str();
+  pageState.mqttPass = mqttPass.c_str();
+  pageState.measureIntervalMs = measureIntervalMs;
+}
 
-  // Configuration Info
-  body += "# HELP hygrometer_config_reference_dry_channel Channel used as dry baseline (-1 if none)\n";
-  body += "hygrometer_config_reference_dry_channel " + String(refChannel) + "\n";
-  body += "# HELP hygrometer_config_global_wet_ohms Global fixed wet limit\n";
-  body += "hygrometer_config_global_wet_ohms " + String(globalWetR) + "\n";
-
+void handleMetrics() {
   // Update references R if configured
   if (refChannel >= 0 && refChannel < NUM_CHANNELS) {
     currentRefR = readChannelResistance(refChannel);
   }
+  collectPageState();
 
-  for (int ch = 0; ch < NUM_CHANNELS; ++ch) {
-    float curAdc, curVout;
-    float r = readChannelResistance(ch, &curAdc, &curVout);
-    float d, w;
-    getEffectiveLimits(ch, d, w);
-    float idx = indexFromR(r, ch);
+  respBegin("text/plain; version=0.0.4");
+  renderMetrics(resp, pageState);
+  respEnd();
+}
 
-    body += "# HELP hygrometer_adc_raw Raw ADC value from mux\n";
-    body += "hygrometer_adc_raw{channel=\"" + String(ch) + "\"} " + String(curAdc, 1) + "\n";
-    
-    body += "# HELP hygrometer_voltage_volts Measured voltage at Z pin\n";
-    body += "hygrometer_voltage_volts{channel=\"" + String(ch) + "\"} " + String(curVout, 3) + "\n";
+void putChannelFloat(const char* key, int ch, void* values) {
+  prefs.putFloat(key, static_cast<float*>(values)[ch]);
+}
 
-    body += "# HELP hygrometer_resistance_ohms Raw resistance measured at probe\n";
-    body += "hygrometer_resistance_ohms{channel=\"" + String(ch) + "\"} " + String(r, 2) + "\n";
-    
-    body += "# HELP hygrometer_effective_dry_ohms Used dry limit for index calculation\n";
-    body += "hygrometer_effective_dry_ohms{channel=\"" + String(ch) + "\"} " + String(d, 2) + "\n";
-    
-    body += "# HELP hygrometer_effective_wet_ohms Used wet limit for index calculation\n";
-    body += "hygrometer_effective_wet_ohms{channel=\"" + String(ch) + "\"} " + String(w, 2) + "\n";
-    
-    if (idx >= 0) {
-      body += "# HELP hygrometer_index_percent Calculated moisture index\n";
-      body += "hygrometer_index_percent{channel=\"" + String(ch) + "\"} " + String(idx, 2) + "\n";
-    }
-  }
-  server.send(200, "text/plain; version=0.0.4", body);
+void getChannelFloat(const char* key, int ch, void* values) {
+  static_cast<float*>(values)[ch] = prefs.getFloat(key, 0.0);
+}
+
+// Speichert Dry- oder Wet-Werte aller Kanäle im NVS
+void saveBaseline(const char* prefix, float* values, const char* flagKey) {
+  prefs.begin("hygro", false);
+  forEachChannelKey(prefix, putChannelFloat, values);
+  prefs.putBool(flagKey, true);
+  prefs.end();
 }
 
 void handleCalibrateDry() {
@@ -228,13 +254,7 @@ void handleCalibrateDry() {
     dryR[ch] = readChannelResistance(ch);
   }
   hasDry = true;
-  prefs.begin("hygro", false);
-  for (int ch = 0; ch < NUM_CHANNELS; ++ch) {
-    String key = String("dry_") + ch;
-    prefs.putFloat(key.c_str(), dryR[ch]);
-  }
-  prefs.putBool("hasDry", true);
-  prefs.end();
+  saveBaseline("dry", dryR, "hasDry");
   server.send(200, "text/plain", "Calibrated dry for all channels\n");
 }
 
@@ -243,132 +263,16 @@ void handleCalibrateWet() {
     wetR[ch] = readChannelResistance(ch);
   }
   hasWet = true;
-  prefs.begin("hygro", false);
-  for (int ch = 0; ch < NUM_CHANNELS; ++ch) {
-    String key = String("wet_") + ch;
-    prefs.putFloat(key.c_str(), wetR[ch]);
-  }
-  prefs.putBool("hasWet", true);
-  prefs.end();
+  saveBaseline("wet", wetR, "hasWet");
   server.send(200, "text/plain", "Calibrated wet for all channels\n");
 }
 
 void handleRoot() {
-  String html = "<!DOCTYPE html><html><head>";
-  html += "<meta charset='UTF-8'>";
-  if (autoRefresh) {
-    html += "<meta http-equiv='refresh' content='10'>";
-  }
-  html += "<meta name='viewport' content='width=device-width, initial-scale=1'>";
-  html += "<title>Hygrometer Control</title>";
-  html += "<link href='https://cdn.jsdelivr.net/npm/bootstrap@5.3.0/dist/css/bootstrap.min.css' rel='stylesheet'>";
-  html += "<link href='https://cdnjs.cloudflare.com/ajax/libs/font-awesome/6.4.0/css/all.min.css' rel='stylesheet'>";
-  html += "<style>";
-  html += "body { background-color: #f8f9fa; }";
-  html += ".card { margin-bottom: 20px; box-shadow: 0 4px 6px rgba(0,0,0,0.1); }";
-  html += ".status-val { font-size: 1.2rem; font-weight: bold; }";
-  html += ".ch-label { width: 40px; display: inline-block; }";
-  html += ".fa-circle-question { font-size: 0.8rem; color: #6c757d; cursor: help; margin-left: 2px; }";
-  html += ".bg-orange { background-color: #fd7e14 !important; color: white !important; }"; // Bootstrap Orange Custom
-  html += "</style></head><body>";
-  
-  html += "<nav class='navbar navbar-dark bg-primary mb-4'><div class='container-fluid'>";
-  html += "<span class='navbar-brand'><i class='fa-solid fa-droplet me-2'></i>Hygrometer Dashboard</span>";
-  html += "</div></nav>";
+  collectPageState();
 
-  html += "<div class='container'><div class='row'>";
-  
-  // Left Column: Environment & Status
-  html += "<div class='col-md-4'>";
-  html += "<div class='card'><div class='card-header bg-white'><i class='fa-solid fa-wind me-2'></i>Ambient Sensors</div><div class='card-body'>";
-  if (hasSHT) {
-    html += "<p><i class='fa-solid fa-temperature-half me-2 text-danger'></i>Temp: <span class='status-val'>" + String(ambientTemp, 1) + " °C</span></p>";
-    html += "<p><i class='fa-solid fa-cloud-showers-heavy me-2 text-primary'></i>Humidity: <span class='status-val'>" + String(ambientHum, 0) + " %</span></p>";
-  } else {
-    html += "<div class='alert alert-warning small py-1 px-2'>SHT31 not found</div>";
-  }
-  html += "</div></div>";
-
-  html += "<div class='card'><div class='card-header bg-white'><i class='fa-solid fa-link me-2'></i>Endpoints</div><div class='card-body d-grid gap-2'>";
-  html += "<a href='/metrics' class='btn btn-outline-secondary btn-sm text-start'><i class='fa-solid fa-chart-line me-2'></i>Prometheus Metrics</a>";
-  html += "<form action='/reboot' method='POST' onsubmit='return confirm(\"Reboot ESP32?\");'>";
-  html += "<button type='submit' class='btn btn-danger btn-sm w-100'><i class='fa-solid fa-power-off me-2'></i>Reboot ESP</button></form>";
-  html += "</div></div>";
-  html += "</div>";
-
-  // Right Column: Configuration
-  html += "<div class='col-md-8'>";
-  html += "<form action='/save' method='POST'>";
-  
-  // Channel Table
-  html += "<div class='card'><div class='card-header bg-white d-flex justify-content-between align-items-center small'>";
-  html += "<span><i class='fa-solid fa-screwdriver-wrench me-2'></i>Probe Measurements</span>";
-  html += "<span class='badge bg-info text-dark'>Ref Dry: " + String(refChannel >= 0 ? "CH" + String(refChannel) : "None") + "</span></div>";
-  html += "<div class='card-body p-0'><div class='table-responsive'><table class='table table-hover table-sm mb-0'><thead><tr class='table-light'>";
-  html += "<th>CH <i class='fa-solid fa-circle-question' title='Multiplexer Channel (0-7)'></i></th>";
-  html += "<th>Raw Ω <i class='fa-solid fa-circle-question' title='Human readable resistance (k=kiloohm, M=megaohm)'></i></th>";
-  html += "<th>Plain (Metric) <i class='fa-solid fa-circle-question' title='Exact decimal resistance in Ohms for metrics and calibration'></i></th>";
-  html += "<th>ADC <i class='fa-solid fa-circle-question' title='Raw Digital value (0-4095) from the ESP32 ADC pin'></i></th>";
-  html += "<th>Vout <i class='fa-solid fa-circle-question' title='Converted voltage reading (0-3.3V)'></i></th>";
-  html += "<th class='text-end'>Moisture Index <i class='fa-solid fa-circle-question' title='Calculated percentage relative to Dry and Wet references'></i></th></tr></thead><tbody>";
-  for (int i = 0; i < NUM_CHANNELS; ++i) {
-    float curAdc, curVout;
-    float curR = readChannelResistance(i, &curAdc, &curVout);
-    float idx = indexFromR(curR, i);
-    html += "<tr><td class='fw-bold'>" + String(i) + "</td>";
-    html += "<td><small>" + (curR > 999999 ? String(curR/1000000.0, 1) + "M" : (curR > 999 ? String(curR/1000.0, 0) + "k" : String(curR, 0))) + " Ω</small></td>";
-    html += "<td><code>" + String(curR, 2) + "</code></td>";
-    html += "<td><small class='text-muted'>" + String(curAdc, 1) + "</small></td>";
-    html += "<td><small class='text-muted'>" + String(curVout, 3) + "V</small></td>";
-    String badgeColor = "bg-success";
-    String textColor = "text-dark";
-    if (idx > 85) { badgeColor = "bg-danger"; textColor = "text-white"; }
-    else if (idx > 60) { badgeColor = "bg-orange"; textColor = "text-white"; }
-    else if (idx > 25) { badgeColor = "bg-warning"; textColor = "text-dark"; }
-    
-    html += "<td class='text-end'><span class='badge " + badgeColor + " " + textColor + "'>" + String(idx, 0) + "%</span></td></tr>";
-  }
-  html += "</tbody></table></div></div></div>";
-
-  // System Settings
-  html += "<div class='card'><div class='card-header bg-white'><i class='fa-solid fa-gears me-2'></i>System Settings</div><div class='card-body small'>";
-  html += "<div class='row g-3'>";
-  html += "<div class='col-sm-6'><label class='form-label mb-0'>Dry Reference</label><select class='form-select form-select-sm' name='ref_ch'><option value='-1'>None (Manual)</option>";
-  for (int i = 0; i < NUM_CHANNELS; ++i) html += "<option value='" + String(i) + "' " + (refChannel == i ? "selected" : "") + ">CH " + String(i) + "</option>";
-  html += "</select></div>";
-  html += "<div class='col-sm-6'><label class='form-label mb-0'>Global Wet Value (100%)</label><input type='number' step='any' class='form-control form-control-sm' name='global_wet_r' value='" + String(globalWetR, 2) + "' placeholder='e.g. 20000.00'></div>";
-  
-  // Interval with unit selector
-  unsigned long displayInterval = measureIntervalMs / 1000;
-  String unit = "s";
-  if (measureIntervalMs >= 60000 && measureIntervalMs % 60000 == 0) {
-    displayInterval = measureIntervalMs / 60000;
-    unit = "m";
-  }
-  html += "<div class='col-sm-6'><label class='form-label mb-0'>Interval (Unit)</label><div class='input-group input-group-sm'>";
-  html += "<input type='number' class='form-control' name='interval_val' value='" + String(displayInterval) + "'>";
-  html += "<select class='form-select' style='max-width: 80px;' name='interval_unit'>";
-  html += "<option value='s' " + String(unit == "s" ? "selected" : "") + ">sec</option>";
-  html += "<option value='m' " + String(unit == "m" ? "selected" : "") + ">min</option>";
-  html += "</select></div></div>";
-
-  html += "<div class='col-sm-6 d-flex align-items-end gap-3'>";
-  html += "<div class='form-check form-switch'><input class='form-check-input' type='checkbox' name='mqtt_enabled' value='1' " + String(mqttEnabled ? "checked" : "") + "><label class='form-check-label'>MQTT</label></div>";
-  html += "<div class='form-check form-switch'><input class='form-check-input' type='checkbox' name='lcd_enabled' value='1' " + String(lcdEnabled ? "checked" : "") + "><label class='form-check-label'>LCD</label></div>";
-  html += "<div class='form-check form-switch'><input class='form-check-input' type='checkbox' name='auto_refresh' value='1' " + String(autoRefresh ? "checked" : "") + "><label class='form-check-label'>Auto-Refresh</label></div>";
-  html += "</div>";
-
-  html += "<div class='col-sm-12'><hr class='my-2'></div>";
-  html += "<div class='col-md-6'><label class='form-label mb-0 small'>MQTT Server</label><input type='text' class='form-control form-control-sm' name='mqtt_server' value='" + mqttServer + "'></div>";
-  html += "<div class='col-md-2'><label class='form-label mb-0 small'>Port</label><input type='number' class='form-control form-control-sm' name='mqtt_port' value='" + String(mqttPort) + "'></div>";
-  html += "<div class='col-md-2'><label class='form-label mb-0 small'>User</label><input type='text' class='form-control form-control-sm' name='mqtt_user' value='" + mqttUser + "'></div>";
-  html += "<div class='col-md-2'><label class='form-label mb-0 small'>Pass</label><input type='password' class='form-control form-control-sm' name='mqtt_pass' value='" + mqttPass + "'></div>";
-  
-  html += "<div class='col-12 mt-4'><button type='submit' class='btn btn-primary w-100 btn-sm'><i class='fa-solid fa-floppy-disk me-2'></i>Save Configuration</button></div>";
-  html += "</div></div></div>";
-  
-  html += "</div></form></div></div></body></html>";
-  server.send(200, "text/html", html);
+  respBegin("text/html");
+  renderRoot(resp, pageState);
+  respEnd();
 }
 
 void handleSave() {
@@ -504,12 +408,8 @@ void setup() {
   prefs.begin("hygro", true);
   hasDry = prefs.getBool("hasDry", false);
   hasWet = prefs.getBool("hasWet", false);
-  for (int ch = 0; ch < NUM_CHANNELS; ++ch) {
-    String dryKey = String("dry_") + ch;
-    String wetKey = String("wet_") + ch;
-    dryR[ch] = prefs.getFloat(dryKey.c_str(), 0.0);
-    wetR[ch] = prefs.getFloat(wetKey.c_str(), 0.0);
-  }
+  forEachChannelKey("dry", getChannelFloat, dryR);
+  forEachChannelKey("wet", getChannelFloat, wetR);
   refChannel = prefs.getInt("refChannel", -1);
   globalWetR = prefs.getFloat("globalWetR", 0);
   
@@ -573,8 +473,11 @@ void loop() {
       Serial.print(ambientHum, 1); Serial.println("%");
 
       if (mqttEnabled && mqtt.connected()) {
-        mqtt.publish("hygrometer/ambient/temperature", String(ambientTemp, 2).c_str());
-        mqtt.publish("hygrometer/ambient/humidity", String(ambientHum, 2).c_str());
+        char payload[MQTT_PAYLOAD_LEN];
+        formatValue(payload, sizeof(payload), ambientTemp, 2);
+        mqtt.publish("hygrometer/ambient/temperature", payload);
+        formatValue(payload, sizeof(payload), ambientHum, 2);
+        mqtt.publish("hygrometer/ambient/humidity", payload);
       }
     } else {
       Serial.println("Sensor 1 (0x44): Not connected or error");
@@ -613,9 +516,11 @@ void loop() {
 
       // MQTT publish (only if enabled and connected)
       if (mqttEnabled && mqtt.connected()) {
-        String topic = String("hygrometer/channel") + ch + "/state";
-        String payload = (idx >= 0) ? String(idx,2) : String(r,1);
-        mqtt.publish(topic.c_str(), payload.c_str());
+        char topic[MQTT_TOPIC_LEN];
+        char payload[MQTT_PAYLOAD_LEN];
+        formatChannelTopic(topic, sizeof(topic), ch);
+        formatChannelPayload(payload, sizeof(payload), r, idx);
+        mqtt.publish(topic, payload);
       }
       delay(50);
     }
@@ -636,24 +541,12 @@ void loop() {
     if (c == 'D' || c == 'd') {
       for (int ch=0; ch<NUM_CHANNELS; ++ch) dryR[ch] = readChannelResistance(ch);
       hasDry = true;
-      prefs.begin("hygro", false);
-      for (int ch=0; ch<NUM_CHANNELS; ++ch) {
-        String key = String("dry_") + ch;
-        prefs.putFloat(key.c_str(), dryR[ch]);
-      }
-      prefs.putBool("hasDry", true);
-      prefs.end();
+      saveBaseline("dry", dryR, "hasDry");
       Serial.println("Saved dry baseline");
     } else if (c == 'W' || c == 'w') {
       for (int ch=0; ch<NUM_CHANNELS; ++ch) wetR[ch] = readChannelResistance(ch);
       hasWet = true;
-      prefs.begin("hygro", false);
-      for (int ch=0; ch<NUM_CHANNELS; ++ch) {
-        String key = String("wet_") + ch;
-        prefs.putFloat(key.c_str(), wetR[ch]);
-      }
-      prefs.putBool("hasWet", true);
-      prefs.end();
+      saveBaseline("wet", wetR, "hasWet");
       Serial.println("Saved wet baseline");
     }
   }
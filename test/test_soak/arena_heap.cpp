@@ -0,0 +1,131 @@
+#include "arena_heap.h"
+
+#include <errno.h>
+#include <new>
+#include <string.h>
+
+namespace {
+
+const size_t ARENA_SIZE = 4 * 1024 * 1024;
+const size_t ALIGN = 16;
+
+// Blöcke liegen lückenlos hintereinander; size ist die Nutzgröße hinter dem Header
+struct Block {
+  size_t size;
+  size_t used;
+};
+
+alignas(ALIGN) unsigned char arena[ARENA_SIZE];
+bool initialised = false;
+size_t allocations = 0;
+
+Block* first() { return reinterpret_cast<Block*>(arena); }
+Block* next(Block* b) { return reinterpret_cast<Block*>(reinterpret_cast<unsigned char*>(b + 1) + b->size); }
+bool inArena(Block* b) { return reinterpret_cast<unsigned char*>(b) < arena + ARENA_SIZE; }
+
+void init() {
+  first()->size = ARENA_SIZE - sizeof(Block);
+  first()->used = 0;
+  initialised = true;
+}
+
+void* arenaAlloc(size_t n) {
+  if (!initialised) init();
+  if (n > ARENA_SIZE) return nullptr;
+  n = n == 0 ? ALIGN : (n + ALIGN - 1) & ~(ALIGN - 1);
+  for (Block* b = first(); inArena(b); b = next(b)) {
+    if (b->used || b->size < n) continue;
+    if (b->size >= n + sizeof(Block) + ALIGN) {
+      Block* rest = reinterpret_cast<Block*>(reinterpret_cast<unsigned char*>(b + 1) + n);
+      rest->size = b->size - n - sizeof(Block);
+      rest->used = 0;
+      b->size = n;
+    }
+    b->used = 1;
+    ++allocations;
+    return b + 1;
+  }
+  return nullptr;
+}
+
+void arenaFree(void* p) {
+  if (!p) return;
+  reinterpret_cast<Block*>(p)[-1].used = 0;
+  // Benachbarte freie Blöcke zusammenfassen
+  for (Block* b = first(); inArena(b); b = next(b)) {
+    if (b->used) continue;
+    while (inArena(next(b)) && !next(b)->used) b->size += sizeof(Block) + next(b)->size;
+  }
+}
+
+size_t blockSize(void* p) { return reinterpret_cast<Block*>(p)[-1].size; }
+
+} // namespace
+
+ArenaStats arenaStats() {
+  if (!initialised) init();
+  ArenaStats st = {allocations, 0, 0, 0};
+  for (Block* b = first(); inArena(b); b = next(b)) {
+    if (b->used) continue;
+    st.totalFree += b->size;
+    if (b->size > st.largestFree) st.largestFree = b->size;
+    ++st.freeBlocks;
+  }
+  return st;
+}
+
+extern "C" {
+
+void* malloc(size_t n) {
+  void* p = arenaAlloc(n);
+  if (!p) errno = ENOMEM;
+  return p;
+}
+
+void free(void* p) { arenaFree(p); }
+
+void* calloc(size_t count, size_t n) {
+  if (n != 0 && count > (size_t)-1 / n) return nullptr;
+  void* p = malloc(count * n);
+  if (p) memset(p, 0, count * n);
+  return p;
+}
+
+void* realloc(void* p, size_t n) {
+  if (!p) return malloc(n);
+  if (n == 0) {
+    free(p);
+    return nullptr;
+  }
+  if (blockSize(p) >= n) return p;
+  void* q = malloc(n);
+  if (!q) return nullptr;
+  memcpy(q, p, blockSize(p));
+  free(p);
+  return q;
+}
+
+// Höhere Ausrichtung als ALIGN wird nicht unterstützt
+int posix_memalign(void** out, size_t align, size_t n) {
+  if (align > ALIGN) return ENOMEM;
+  *out = malloc(n);
+  return *out ? 0 : ENOMEM;
+}
+
+void* aligned_alloc(size_t align, size_t n) { return align > ALIGN ? nullptr : malloc(n); }
+
+void* memalign(size_t align, size_t n) { return aligned_alloc(align, n); }
+
+} // extern "C"
+
+void* operator new(size_t n) {
+  void* p = malloc(n);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](size_t n) { return operator new(n); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stddef.h>
+
+// Ersetzt malloc/free/new/delete durch einen First-Fit-Heap auf einem festen
+// Arena-Block (ähnlich dem ESP32-Heap), damit Allokationen gezählt und die
+// Fragmentierung gemessen werden können
+
+struct ArenaStats {
+  size_t allocations; // erfolgreiche malloc/new seit Programmstart
+  size_t totalFree;
+  size_t largestFree;
+  size_t freeBlocks;
+};
+
+ArenaStats arenaStats();
@@ -0,0 +1,252 @@
+// Soak-Test für die Heap-Stabilität: spielt Messzyklen, /metrics- und /-Abrufe
+// sowie Kalibrierungs-Speicherungen millionenfach ab und prüft, dass nach dem
+// Aufwärmen keine einzige Allokation mehr stattfindet
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#include "HygroFormat.h"
+#include "arena_heap.h"
+
+#ifndef SOAK_SCANS
+#define SOAK_SCANS 2000000UL
+#endif
+#ifndef SOAK_SCRAPES
+#define SOAK_SCRAPES 1000000UL
+#endif
+#ifndef SOAK_PAGES
+#define SOAK_PAGES 50000UL
+#endif
+#ifndef SOAK_SAVES
+#define SOAK_SAVES 1000000UL
+#endif
+
+// Zählt nur die Bytes, wie ein WebServer-Client der alles verwirft
+class CountingSink : public ResponseSink {
+public:
+  void write(const char*, size_t len) override { bytes += len; }
+  unsigned long long bytes = 0;
+};
+
+// Sammelt die Ausgabe zum Vergleichen
+class CaptureSink : public ResponseSink {
+public:
+  void write(const char* data, size_t n) override {
+    if (len + n >= sizeof(text)) n = sizeof(text) - 1 - len;
+    memcpy(text + len, data, n);
+    len += n;
+    text[len] = '\0';
+    ++writes;
+  }
+  char text[32768] = {};
+  size_t len = 0;
+  int writes = 0;
+};
+
+static unsigned long rng = 12345;
+
+static float nextFloat(float lo, float hi) {
+  rng = rng * 1103515245UL + 12345UL;
+  return lo + (hi - lo) * ((rng >> 8) & 0xFFFF) / 65535.0f;
+}
+
+static void fillState(HygroState& st) {
+  st.hasSHT = true;
+  st.ambientTemp = nextFloat(-10, 40);
+  st.ambientHum = nextFloat(0, 100);
+  for (int ch = 0; ch < HYGRO_NUM_CHANNELS; ++ch) {
+    ChannelReading& c = st.channels[ch];
+    c.adc = nextFloat(0, 4095);
+    c.vout = c.adc / 4095.0f * 3.3f;
+    // Ganze Bandbreite inkl. offener Kontakt (1e9) abdecken
+    c.r = ch == 7 ? 1e9f : nextFloat(10, 5e7f);
+    c.dryLimit = 5000000.0f;
+    c.wetLimit = 20000.0f;
+    c.index = nextFloat(0, 100);
+  }
+  st.heapFree = 180000;
+  st.heapLargest = 110000;
+  st.refChannel = 3;
+  st.globalWetR = 20000.0f;
+  st.mqttEnabled = true;
+  st.lcdEnabled = true;
+  st.autoRefresh = (rng & 1) != 0;
+  st.mqttServer = "mqtt.example.local";
+  st.mqttPort = 1883;
+  st.mqttUser = "hygro";
+  st.mqttPass = "secret";
+  st.measureIntervalMs = (rng & 2) ? 120000UL : 10000UL;
+}
+
+// Entspricht dem MQTT-Teil eines Messzyklus in loop()
+static size_t scan(const HygroState& st) {
+  char topic[MQTT_TOPIC_LEN];
+  char payload[MQTT_PAYLOAD_LEN];
+  size_t n = 0;
+  formatValue(payload, sizeof(payload), st.ambientTemp, 2);
+  n += strlen(payload);
+  formatValue(payload, sizeof(payload), st.ambientHum, 2);
+  n += strlen(payload);
+  for (int ch = 0; ch < HYGRO_NUM_CHANNELS; ++ch) {
+    const ChannelReading& c = st.channels[ch];
+    formatChannelTopic(topic, sizeof(topic), ch);
+    formatChannelPayload(payload, sizeof(payload), c.r, c.index);
+    n += strlen(topic) + strlen(payload);
+  }
+  return n;
+}
+
+static void countKey(const char* key, int, void* total) {
+  *static_cast<size_t*>(total) += strlen(key);
+}
+
+// Entspricht saveBaseline() für dry und wet
+static size_t save() {
+  size_t n = 0;
+  forEachChannelKey("dry", countKey, &n);
+  forEachChannelKey("wet", countKey, &n);
+  return n;
+}
+
+// Abstand in Scans zwischen zwei Aufrufen, damit n Aufrufe auf total Scans
+// verteilt werden; mindestens 1, 0 heißt nie
+static unsigned long stride(unsigned long total, unsigned long n) {
+  if (n == 0) return 0;
+  return n >= total ? 1 : total / n;
+}
+
+static void printStats(const char* label, const ArenaStats& st) {
+  double frag = st.totalFree ? 100.0 * (1.0 - (double)st.largestFree / st.totalFree) : 0.0;
+  printf("%s: allocations=%zu free=%zu largest=%zu blocks=%zu fragmentation=%.2f%%\n",
+         label, st.allocations, st.totalFree, st.largestFree, st.freeBlocks, frag);
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_arena_counts_allocations() {
+  // volatile, damit der Compiler das new/malloc-Paar nicht wegoptimiert
+  static int* volatile p;
+  static void* volatile q;
+  size_t before = arenaStats().allocations;
+  p = new int(42);
+  q = malloc(100);
+  TEST_ASSERT_EQUAL_UINT(before + 2, arenaStats().allocations);
+  free(q);
+  delete p;
+}
+
+void test_writer_splits_across_flushes() {
+  CaptureSink sink;
+  ResponseWriter out(sink);
+  char line[101];
+  memset(line, 'x', 100);
+  line[100] = '\0';
+  for (int i = 0; i < 20; ++i) {
+    out.add(line);
+    out.addf("<%d>", i);
+  }
+  TEST_ASSERT_EQUAL_UINT(0, out.finish());
+  TEST_ASSERT_GREATER_THAN(1, sink.writes);
+
+  char expected[4096] = {};
+  size_t len = 0;
+  for (int i = 0; i < 20; ++i) len += snprintf(expected + len, sizeof(expected) - len, "%s<%d>", line, i);
+  TEST_ASSERT_EQUAL_STRING(expected, sink.text);
+}
+
+void test_addf_reports_oversized_line() {
+  CaptureSink sink;
+  ResponseWriter out(sink);
+  char big[ResponseWriter::CAPACITY + 50];
+  memset(big, 'y', sizeof(big) - 1);
+  big[sizeof(big) - 1] = '\0';
+  out.add("ok");
+  out.addf("%s", big);
+  out.addf("%d", 7);
+  TEST_ASSERT_EQUAL_UINT(1, out.finish());
+  TEST_ASSERT_EQUAL_UINT(0, out.finish());
+  TEST_ASSERT_EQUAL_UINT(2 + ResponseWriter::CAPACITY - 1 + 1, sink.len);
+}
+
+void test_pages_render_complete() {
+  static HygroState st;
+  fillState(st);
+  CaptureSink sink;
+  ResponseWriter out(sink);
+
+  renderMetrics(out, st);
+  TEST_ASSERT_EQUAL_UINT(0, out.finish());
+  TEST_ASSERT_NOT_NULL(strstr(sink.text, "hygrometer_resistance_ohms{channel=\"7\"} 1000000000.00\n"));
+  TEST_ASSERT_NOT_NULL(strstr(sink.text, "hygrometer_heap_largest_block_bytes 110000\n"));
+
+  sink.len = 0;
+  renderRoot(out, st);
+  TEST_ASSERT_EQUAL_UINT(0, out.finish());
+  TEST_ASSERT_NOT_NULL(strstr(sink.text, "name='mqtt_server' value='mqtt.example.local'"));
+  TEST_ASSERT_EQUAL_STRING("</body></html>", sink.text + sink.len - strlen("</body></html>"));
+}
+
+void test_soak_zero_steady_state_allocations() {
+  static HygroState st;
+  CountingSink sink;
+  static ResponseWriter out(sink);
+
+  // Aufwärmen: stdio-Puffer und Ähnliches dürfen einmalig allokieren
+  fillState(st);
+  scan(st);
+  save();
+  renderMetrics(out, st);
+  renderRoot(out, st);
+  out.finish();
+  printf("\n");
+
+  ArenaStats before = arenaStats();
+  printStats("before soak", before);
+
+  const unsigned long scans = SOAK_SCANS;
+  const unsigned long scrapeEvery = stride(scans, SOAK_SCRAPES);
+  const unsigned long pageEvery = stride(scans, SOAK_PAGES);
+  const unsigned long saveEvery = stride(scans, SOAK_SAVES);
+  unsigned long scrapes = 0, pages = 0, saves = 0;
+  size_t truncated = 0;
+  unsigned long long formatted = 0;
+  for (unsigned long i = 0; i < scans; ++i) {
+    fillState(st);
+    formatted += scan(st);
+    if (scrapeEvery && i % scrapeEvery == 0) {
+      renderMetrics(out, st);
+      truncated += out.finish();
+      ++scrapes;
+    }
+    if (pageEvery && i % pageEvery == 0) {
+      renderRoot(out, st);
+      truncated += out.finish();
+      ++pages;
+    }
+    if (saveEvery && i % saveEvery == 0) {
+      formatted += save();
+      ++saves;
+    }
+  }
+
+  ArenaStats after = arenaStats();
+  printStats("after soak", after);
+  printf("scans=%lu scrapes=%lu pages=%lu saves=%lu response_bytes=%llu formatted_bytes=%llu\n",
+         scans, scrapes, pages, saves, sink.bytes, formatted);
+
+  TEST_ASSERT_EQUAL_UINT(0, truncated);
+  TEST_ASSERT_EQUAL_UINT_MESSAGE(before.allocations, after.allocations, "heap allocations during soak");
+  TEST_ASSERT_EQUAL_UINT_MESSAGE(before.largestFree, after.largestFree, "largest free block shrank");
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_arena_counts_allocations);
+  RUN_TEST(test_writer_splits_across_flushes);
+  RUN_TEST(test_addf_reports_oversized_line);
+  RUN_TEST(test_pages_render_complete);
+  RUN_TEST(test_soak_zero_steady_state_allocations);
+  return UNITY_END();
+}